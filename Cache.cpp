@@ -0,0 +1,156 @@
+/* 
+ * File:   Cache.cpp
+ * Author: jacob
+ * 
+ * Created on October 19, 2026, 5:20 PM
+ */
+
+#include "Cache.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+/*
+ * FNV-1a over some bytes, carrying on from a previous hash.
+ */
+static unsigned long long fnv(unsigned long long hash, const void* data, size_t len){
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i = 0; i < len; i++){
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/*
+ * Constructor
+ * Opens the cache file, making it if needed, and indexes what is there.
+ * 
+ * char* filename - the cache file
+ */
+ResultCache::ResultCache(char* filename) {
+    read_to = 0;
+    fd = open(filename, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if(fd != -1) read_new();
+}
+
+ResultCache::~ResultCache() {
+    if(fd != -1) close(fd);
+}
+
+bool ResultCache::isOpen(){
+    return (fd != -1);
+}
+
+/*
+ * Hashes the contents of a tracefile.
+ * Returns 0 if the file could not be read.
+ */
+unsigned long long ResultCache::hashFile(char* filename){
+    unsigned char buff[65536];
+    size_t len;
+    unsigned long long hash = FNV_OFFSET;
+    FILE* f = fopen(filename, "rb");
+    if(f == NULL) return 0;
+    while((len = fread(buff, 1, sizeof(buff), f)) > 0) hash = fnv(hash, buff, len);
+    fclose(f);
+    return hash;
+}
+
+/*
+ * Fills in a key. Anything the algorithm does not use should be passed as -1,
+ * and slow and promote as 0 when there is no slow tier.
+ */
+void ResultCache::makeKey(RunKey* key, unsigned long long trace_hash, int alg, int frames,
+        int refresh, int tau, int slow, int promote){
+    memset(key, 0, sizeof(RunKey));
+    key->trace_hash = trace_hash;
+    key->version = CACHE_VERSION;
+    key->alg = alg;
+    key->frames = frames;
+    key->refresh = refresh;
+    key->tau = tau;
+    key->slow = slow;
+    key->promote = promote;
+}
+
+unsigned long long ResultCache::key_of(RunKey* key){
+    return fnv(FNV_OFFSET, key, sizeof(RunKey));
+}
+
+unsigned int ResultCache::checksum(CacheEntry* e){
+    unsigned long long hash = fnv(FNV_OFFSET, &e->key, sizeof(RunKey) + sizeof(RunStats));
+    return (unsigned int)(hash ^ (hash >> 32));
+}
+
+/*
+ * Indexes any records added to the file since it was last read.
+ * Other processes may have added some.
+ * A partial record at the end is being written or was cut off, so it is left alone.
+ */
+void ResultCache::read_new(){
+    CacheEntry e;
+    struct stat st;
+    flock(fd, LOCK_SH);
+    if(fstat(fd, &st) != 0 || st.st_size <= read_to){
+        flock(fd, LOCK_UN);
+        return;
+    }
+    // The whole unread tail comes in with one read instead of one per record.
+    long long len = st.st_size - read_to;
+    char* buff = new char[len];
+    long long got = 0;
+    ssize_t n;
+    while(got < len && (n = pread(fd, buff + got, len - got, read_to + got)) > 0) got += n;
+    flock(fd, LOCK_UN);
+    long long i;
+    for(i = 0; i + (long long)sizeof(e) <= got; i += sizeof(e)){
+        memcpy(&e, buff + i, sizeof(e));
+        // Skip anything damaged or from another version.
+        if(e.magic != CACHE_MAGIC || e.key.version != CACHE_VERSION || e.check != checksum(&e)) continue;
+        index[key_of(&e.key)] = e;
+    }
+    read_to += i;
+    delete[] buff;
+}
+
+/*
+ * Looks for a cached result. Returns true and fills in stats if there is one.
+ */
+bool ResultCache::lookup(RunKey* key, RunStats* stats){
+    if(fd == -1) return false;
+    read_new();
+    std::unordered_map<unsigned long long, CacheEntry>::iterator it = index.find(key_of(key));
+    if(it == index.end()) return false;
+    // Make sure it is not just a hash collision.
+    if(memcmp(&it->second.key, key, sizeof(RunKey))) return false;
+    *stats = it->second.stats;
+    return true;
+}
+
+/*
+ * Appends a result to the file.
+ * The record goes in with one write under an exclusive lock.
+ */
+void ResultCache::store(RunKey* key, RunStats* stats){
+    CacheEntry e;
+    struct stat st;
+    if(fd == -1) return;
+    e.magic = CACHE_MAGIC;
+    e.key = *key;
+    e.stats = *stats;
+    e.check = checksum(&e);
+    
+    flock(fd, LOCK_EX);
+    // A process that died mid write can leave a partial record. Cut it off so records stay aligned.
+    if(fstat(fd, &st) == 0 && st.st_size % sizeof(e) != 0) ftruncate(fd, st.st_size - st.st_size % sizeof(e));
+    if(write(fd, &e, sizeof(e)) != sizeof(e)) perror("Failed to write to the result cache");
+    flock(fd, LOCK_UN);
+    index[key_of(key)] = e;
+}
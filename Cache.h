@@ -0,0 +1,66 @@
+/* 
+ * File:   Cache.h
+ * Author: jacob
+ *
+ * Created on October 19, 2026, 5:20 PM
+ */
+
+#ifndef CACHE_H
+#define	CACHE_H
+#include <unordered_map>
+#include "PageTable.h"
+#define CACHE_MAGIC 0x564D5243 // "VMRC" at the start of every record.
+#define CACHE_VERSION 2 // Bump when a change to the simulator changes results.
+
+/*
+ * Everything a result depends on.
+ * Always memset to 0 before filling in so it hashes the same every time.
+ */
+typedef struct RunKey{
+    unsigned long long trace_hash; // Hash of the tracefile contents.
+    int version; // CACHE_VERSION
+    int alg; // The full configuration. Anything not used is -1 or 0.
+    int frames;
+    int refresh;
+    int tau;
+    int slow;
+    int promote;
+    int reserved; // Keeps the struct free of padding. Always 0.
+} RunKey;
+
+/*
+ * One cached result. Every record in the file is exactly this size.
+ */
+typedef struct CacheEntry{
+    unsigned int magic; // CACHE_MAGIC
+    unsigned int check; // Checksum of the rest of the record.
+    RunKey key;
+    RunStats stats;
+} CacheEntry;
+
+/*
+ * An on disk store of results keyed by the trace and configuration.
+ * The file is only ever appended to, one fixed size record at a time,
+ * under a lock so many vmsim processes can share it.
+ * Records are indexed in memory as they are read.
+ */
+class ResultCache {
+public:
+    ResultCache(char*);
+    virtual ~ResultCache();
+    bool isOpen();
+    bool lookup(RunKey*, RunStats*);
+    void store(RunKey*, RunStats*);
+    static void makeKey(RunKey*, unsigned long long, int, int, int, int, int, int);
+    static unsigned long long hashFile(char*);
+private:
+    void read_new();
+    static unsigned long long key_of(RunKey*);
+    static unsigned int checksum(CacheEntry*);
+    int fd; // The cache file.
+    long long read_to; // How far into the file has been indexed.
+    std::unordered_map<unsigned long long, CacheEntry> index; // Key hash to record.
+};
+
+#endif	/* CACHE_H */
+
@@ -0,0 +1,294 @@
+/* 
+ * File:   Check.cpp
+ * Author: jacob
+ * 
+ * Created on October 19, 2026, 4:30 PM
+ */
+
+#include "Check.h"
+#include "PageTable.h"
+#include "Trace.h"
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <cstdlib>
+#include <unistd.h>
+
+#define NUM_TRACES 3
+
+typedef struct GoldenRun{
+    int trace; // Which generated trace.
+    int alg;
+    int frames;
+    int refresh; // -1 if not used.
+    int tau; // -1 if not used.
+    int slow; // Slow tier frames. 0 if not used.
+    int promote;
+    unsigned int mem_accesses; // The known good stats.
+    int page_faults;
+    int total_writes;
+} GoldenRun;
+
+static const char* trace_names[NUM_TRACES] = {"loop", "hot", "phases"};
+static const char* alg_names[4] = {"OPT", "CLOCK", "AGING", "WORKING_SET_CLOCK"};
+
+/*
+ * Known good results. If a change to the simulator is meant to change these,
+ * the check prints the new rows to paste in.
+ * The rows without a slow tier match the original simulator on the loop and
+ * phases traces, and on the hot trace with page 0xFFFFF left out since that page
+ * was past the end of its page table.
+ * The slow tier is new so there is nothing older to compare with. Those rows
+ * are just what this code gave after the slow tier clock hand fix (928281a).
+ */
+static const GoldenRun golden[] = {
+    {0, OPT, 4, -1, -1, 0, 1, 30000, 27693, 9119},
+    {0, OPT, 16, -1, -1, 0, 1, 30000, 18472, 9119},
+    {0, CLOCK, 4, -1, -1, 0, 1, 30000, 30000, 9119},
+    {0, CLOCK, 16, -1, -1, 0, 1, 30000, 30000, 9119},
+    {0, AGING, 4, 8, -1, 0, 1, 30000, 30000, 9119},
+    {0, AGING, 16, 8, -1, 0, 1, 30000, 30000, 9119},
+    {0, AGING, 16, 1, -1, 0, 1, 30000, 24008, 9119},
+    {0, WORKING_SET_CLOCK, 4, 8, 32, 0, 1, 30000, 30000, 9119},
+    {0, WORKING_SET_CLOCK, 16, 8, 32, 0, 1, 30000, 30000, 9119},
+    {0, WORKING_SET_CLOCK, 16, 100, 5, 0, 1, 30000, 30000, 9119},
+    {0, OPT, 4, -1, -1, 8, 2, 30000, 27693, 9119},
+    {0, CLOCK, 4, -1, -1, 8, 1, 30000, 30000, 9119},
+    {0, AGING, 4, 8, -1, 8, 2, 30000, 30000, 9119},
+    {0, WORKING_SET_CLOCK, 4, 8, 32, 8, 3, 30000, 30000, 9119},
+    {1, OPT, 4, -1, -1, 0, 1, 30000, 7542, 9074},
+    {1, OPT, 16, -1, -1, 0, 1, 30000, 2726, 9074},
+    {1, CLOCK, 4, -1, -1, 0, 1, 30000, 10184, 9074},
+    {1, CLOCK, 16, -1, -1, 0, 1, 30000, 5881, 9074},
+    {1, AGING, 4, 8, -1, 0, 1, 30000, 10189, 9074},
+    {1, AGING, 16, 8, -1, 0, 1, 30000, 5556, 9074},
+    {1, AGING, 16, 1, -1, 0, 1, 30000, 6116, 9074},
+    {1, WORKING_SET_CLOCK, 4, 8, 32, 0, 1, 30000, 10163, 9074},
+    {1, WORKING_SET_CLOCK, 16, 8, 32, 0, 1, 30000, 6002, 9074},
+    {1, WORKING_SET_CLOCK, 16, 100, 5, 0, 1, 30000, 6039, 9074},
+    {1, OPT, 4, -1, -1, 8, 2, 30000, 6308, 9074},
+    {1, CLOCK, 4, -1, -1, 8, 1, 30000, 7000, 9074},
+    {1, AGING, 4, 8, -1, 8, 2, 30000, 6940, 9074},
+    {1, WORKING_SET_CLOCK, 4, 8, 32, 8, 3, 30000, 6967, 9074},
+    {2, OPT, 4, -1, -1, 0, 1, 30000, 9609, 8931},
+    {2, OPT, 16, -1, -1, 0, 1, 30000, 3430, 8931},
+    {2, CLOCK, 4, -1, -1, 0, 1, 30000, 12909, 8931},
+    {2, CLOCK, 16, -1, -1, 0, 1, 30000, 7362, 8931},
+    {2, AGING, 4, 8, -1, 0, 1, 30000, 12884, 8931},
+    {2, AGING, 16, 8, -1, 0, 1, 30000, 7196, 8931},
+    {2, AGING, 16, 1, -1, 0, 1, 30000, 10850, 8931},
+    {2, WORKING_SET_CLOCK, 4, 8, 32, 0, 1, 30000, 12893, 8931},
+    {2, WORKING_SET_CLOCK, 16, 8, 32, 0, 1, 30000, 7483, 8931},
+    {2, WORKING_SET_CLOCK, 16, 100, 5, 0, 1, 30000, 7425, 8931},
+    {2, OPT, 4, -1, -1, 8, 2, 30000, 8194, 8931},
+    {2, CLOCK, 4, -1, -1, 8, 1, 30000, 9029, 8931},
+    {2, AGING, 4, 8, -1, 8, 2, 30000, 8992, 8931},
+    {2, WORKING_SET_CLOCK, 4, 8, 32, 8, 3, 30000, 9002, 8931},
+};
+
+/*
+ * A small random number generator so the traces are the same everywhere.
+ */
+static unsigned int rand_state;
+static unsigned int next_rand(){
+    rand_state = rand_state * 1664525 + 1013904223;
+    return rand_state >> 8;
+}
+
+/*
+ * Makes an address somewhere in the given page.
+ */
+static unsigned int page_adr(unsigned int page){
+    return (page << 12) | (next_rand() & 0xFFF);
+}
+
+/*
+ * Builds one of the generated traces.
+ * loop   - sweeps the same 40 pages over and over. Bad for LRU like algorithms.
+ * hot    - mostly a few hot pages with runs of repeats, plus cold pages.
+ *          The top page of the address space is one of the hot ones.
+ * phases - the working set jumps to a new spot every so often.
+ */
+static Trace* make_trace(int which, int accesses){
+    Trace* tr = new Trace();
+    int i, k;
+    rand_state = which + 1;
+    for(i = 0; i < accesses;){
+        unsigned int r = next_rand();
+        unsigned int page;
+        int run = 1;
+        if(which == 0) page = 0x100 + i % 40;
+        else if(which == 1){
+            if(r % 10 < 8) page = (r % 16 == 0) ? 0xFFFFF : 0x2000 + (r >> 4) % 16;
+            else page = 0x40000 + (r >> 4) % 512;
+            run = 1 + (r >> 12) % 4;
+        }
+        else{
+            if(r % 10 < 9) page = 0x8000 + (i / 4000) * 64 + (r >> 4) % 24;
+            else page = 0x9000 + (r >> 4) % 1024;
+            run = 1 + (r >> 12) % 3;
+        }
+        for(k = 0; k < run && i < accesses; k++, i++){
+            // Kept as two statements so the order of the random calls is fixed.
+            unsigned int adr = page_adr(page);
+            tr->addAccess(adr, next_rand() % 10 < 3);
+        }
+    }
+    return tr;
+}
+
+/*
+ * Runs one configuration over a trace.
+ */
+static PageTable* run_config(Trace* tr, char* filename, const GoldenRun& g){
+    PageTable* pt;
+    if(filename != NULL) pt = new PageTable(g.frames, g.alg, filename);
+    else pt = new PageTable(g.frames, g.alg, tr);
+    if(g.refresh != -1) pt->setRefresh(g.refresh);
+    if(g.tau != -1) pt->setTau(g.tau);
+    if(g.slow > 0){
+        pt->setSlowTier(g.slow);
+        pt->setPromoteAfter(g.promote);
+    }
+    pt->beginFileTraverse();
+    return pt;
+}
+
+/*
+ * Writes a trace out as a tracefile so the file reading path can be checked.
+ * Returns false if the file could not be made.
+ */
+static bool write_trace(Trace* tr, char* filename){
+    int fd = mkstemp(filename);
+    if(fd == -1) return false;
+    FILE* f = fdopen(fd, "w");
+    if(f == NULL){
+        close(fd);
+        unlink(filename);
+        return false;
+    }
+    TraceRecord* recs = tr->getRecords();
+    int i;
+    for(i = 0; i < tr->getSize(); i++) fprintf(f, "%08x %c\n", recs[i].adr, recs[i].isWriting ? 'W' : 'R');
+    fclose(f);
+    return true;
+}
+
+/*
+ * Runs every golden configuration over its trace three ways: from memory,
+ * from a tracefile, and collapsed.
+ * Prints a row for each that does not match.
+ */
+int checkGolden(){
+    const char* pass_names[3] = {"", " file", " collapsed"};
+    int i, t, pass;
+    int failed = 0;
+    int runs = 0;
+    int num_golden = sizeof(golden) / sizeof(golden[0]);
+    for(t = 0; t < NUM_TRACES; t++){
+        Trace* tr = make_trace(t, 30000);
+        // Written before collapsing so the file has one line per access.
+        char filename[] = "/tmp/vmsim_checkXXXXXX";
+        if(!write_trace(tr, filename)){
+            printf("FAIL %s: could not write a tracefile\n", trace_names[t]);
+            failed++;
+            delete tr;
+            continue;
+        }
+        for(pass = 0; pass < 3; pass++){
+            // The last pass makes sure collapsing does not change anything.
+            if(pass == 2) tr->reduce();
+            for(i = 0; i < num_golden; i++){
+                if(golden[i].trace != t) continue;
+                PageTable* pt = run_config(tr, pass == 1 ? filename : NULL, golden[i]);
+                runs++;
+                if(pt->getMemAccesses() != golden[i].mem_accesses ||
+                        pt->getPageFaults() != golden[i].page_faults ||
+                        pt->getTotalWrites() != golden[i].total_writes){
+                    failed++;
+                    printf("FAIL %s%s: expected %u accesses %d faults %d writes\n", trace_names[t],
+                            pass_names[pass], golden[i].mem_accesses,
+                            golden[i].page_faults, golden[i].total_writes);
+                    printf("    {%d, %s, %d, %d, %d, %d, %d, %u, %d, %d},\n", t, alg_names[golden[i].alg],
+                            golden[i].frames, golden[i].refresh, golden[i].tau, golden[i].slow,
+                            golden[i].promote, pt->getMemAccesses(), pt->getPageFaults(),
+                            pt->getTotalWrites());
+                }
+                delete pt;
+            }
+        }
+        unlink(filename);
+        delete tr;
+    }
+    printf("%d of %d golden runs passed.\n", runs - failed, runs);
+    return failed ? 1 : 0;
+}
+
+/*
+ * Times each algorithm over a large generated trace.
+ * The accesses/sec are compared against the baseline file.
+ * If there is no baseline yet, the results are written as the baseline.
+ * 
+ * char* baseline  - file of "<algorithm> <accesses/sec>" lines
+ * double max_drop - the percent below the baseline that still passes
+ */
+int checkThroughput(char* baseline, double max_drop){
+    const char* names[4] = {"opt", "clock", "aging", "working"};
+    double rates[4];
+    int failed = 0;
+    int alg, run;
+    Trace* tr = make_trace(1, BENCH_ACCESSES);
+    for(alg = OPT; alg <= WORKING_SET_CLOCK; alg++){
+        GoldenRun g = {1, alg, 64, -1, -1, 0, 1, 0, 0, 0};
+        if(alg == AGING || alg == WORKING_SET_CLOCK) g.refresh = 100;
+        if(alg == WORKING_SET_CLOCK) g.tau = 500;
+        rates[alg] = 0;
+        for(run = 0; run < BENCH_RUNS; run++){
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            PageTable* pt = run_config(tr, NULL, g);
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double rate = pt->getMemAccesses() / secs;
+            if(rate > rates[alg]) rates[alg] = rate;
+            delete pt;
+        }
+    }
+    delete tr;
+    
+    FILE* f = fopen(baseline, "r");
+    if(f == NULL){
+        // No baseline yet. Record this run as the baseline.
+        f = fopen(baseline, "w");
+        if(f == NULL){
+            printf("Failed to write the baseline %s\n", baseline);
+            return 1;
+        }
+        for(alg = OPT; alg <= WORKING_SET_CLOCK; alg++){
+            fprintf(f, "%s %.0f\n", names[alg], rates[alg]);
+            printf("%-8s %14.0f accesses/sec (recorded)\n", names[alg], rates[alg]);
+        }
+        fclose(f);
+        return 0;
+    }
+    char name[16];
+    double base;
+    bool seen[4] = {false, false, false, false};
+    while(fscanf(f, "%15s %lf", name, &base) == 2){
+        for(alg = OPT; alg <= WORKING_SET_CLOCK; alg++){
+            if(strcmp(name, names[alg])) continue;
+            seen[alg] = true;
+            double floor = base * (1 - max_drop / 100);
+            bool ok = rates[alg] >= floor;
+            if(!ok) failed++;
+            printf("%-8s %14.0f accesses/sec baseline %14.0f %s\n", names[alg], rates[alg], base,
+                    ok ? "ok" : "FAIL");
+        }
+    }
+    fclose(f);
+    // A baseline missing an algorithm would let that one through unchecked.
+    for(alg = OPT; alg <= WORKING_SET_CLOCK; alg++){
+        if(seen[alg]) continue;
+        failed++;
+        printf("%-8s %14.0f accesses/sec no baseline FAIL\n", names[alg], rates[alg]);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+/* 
+ * File:   Check.h
+ * Author: jacob
+ *
+ * Created on October 19, 2026, 4:30 PM
+ */
+
+#ifndef CHECK_H
+#define	CHECK_H
+#define BENCH_ACCESSES 2000000 // Size of the trace timed by the throughput check.
+#define BENCH_RUNS 3 // The best of this many runs is kept for each algorithm.
+#define BENCH_MAX_DROP 20 // Default percent accesses/sec can drop before failing.
+
+/*
+ * Self checks for the simulator.
+ * checkGolden runs every algorithm over generated traces and compares
+ * the stats against known good values. checkThroughput times each
+ * algorithm and compares it against a stored baseline.
+ * Both return 0 if everything passed.
+ */
+int checkGolden();
+int checkThroughput(char*, double);
+
+#endif	/* CHECK_H */
+
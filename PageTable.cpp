@@ -9,7 +9,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
-#include <queue>
+#include <vector>
 #include <unistd.h>
 
 /*
@@ -20,51 +20,93 @@
  * char** filename - the name of the tracefile to be used 
  */
 PageTable::PageTable(int frames, int alg, char* filename) {
+    init(frames, alg);
+    
+    // We are gonna want to open the file.
+    trace = NULL;
+    tracefile = fopen(filename, "r");
+}
+
+/*
+ * Constructor
+ * Same as above but runs over a trace that is already in memory.
+ * The trace is not owned by the page table and must outlive it.
+ * 
+ * int frame - The number of frames in physical memory
+ * int alg   - The algorithm to be used for evicting pages 
+ * Trace* tr - the loaded trace to be used 
+ */
+PageTable::PageTable(int frames, int alg, Trace* tr) {
+    init(frames, alg);
+    
+    tracefile = NULL;
+    trace = tr;
+}
+
+/*
+ * Sets up the frames, the page table and the stats.
+ * Shared by both constructors.
+ */
+void PageTable::init(int frames, int alg){
     // Lets first setup the physical memory.
     num_frames = frames;
-    fTable = new TableEntry*[num_frames];
-    // Now lets set each frame to NULL
-    for(int i = 0; i < num_frames; i++) fTable[i] = NULL;
+    fTable = new int[num_frames];
+    frame_time = new unsigned int[num_frames];
+    frame_age = new unsigned char[num_frames];
+    // Now lets set each frame to empty
+    for(int i = 0; i < num_frames; i++){
+        fTable[i] = NO_FRAME;
+        frame_time[i] = 0;
+        frame_age[i] = 0;
+    }
+    next_occur = NULL;
+#ifndef USEOLDFUTURE
+    future = NULL;
+#endif
+    
+    // No slow tier until one is set.
+    slow_frames = 0;
+    slow_used = 0;
+    slow_hand = 0;
+    promote_after = 1;
+    sTable = NULL;
+    slow_uses = NULL;
+    fast_cost = FAST_COST;
+    slow_cost = SLOW_COST;
+    disk_cost = DISK_COST;
     
     // Next lets initialize the actual page table.
-    // First lets see how many pages there are.
-    num_pages = PAGE_ADDRESS_AND >> 12;
+    // First lets see how many pages there are. Page numbers go up to PAGE_ADDRESS_AND >> 12.
+    num_pages = (PAGE_ADDRESS_AND >> 12) + 1;
     pTable = new TableEntry[num_pages];
     
     // Initialize all the pages.
     for(int i = 0; i < num_pages; i++){
-        pTable[i].frameNum = -1;
-        pTable[i].isDirty = false;
+        pTable[i].frameNum = 0;
+        pTable[i].isValid = 0;
+        pTable[i].isDirty = 0;
         pTable[i].isReferenced = 0;
-        pTable[i].timeStamp = -1;
+        pTable[i].tag = 0;
     }
     
-    // We are gonna want to open the file.
-    tracefile = fopen(filename, "r");
-    
-#ifdef USEOLDFUTURE
-    // Future table for opt initialize
-    next_occur = NULL;
-#else
-    // Initial recording of future.
-    if(tracefile != NULL && alg == OPT) find_future_t();
-#endif
-    
-    
-    
     // Initialize the stat variables
     page_faults = 0;
     mem_accesses = 0;
     total_writes = 0;
+    slow_hits = 0;
+    promotions = 0;
+    demotions = 0;
     
     age = 0;
+    clock_hand = 0;
+    trace_pos = 0;
+    profiler = NULL;
     
     parameter = -1;
     tau = -1;
     
     frames_used = 0; // At the start 0 frames are being used.
     algorithm = alg;
-    
 }
 
 PageTable::PageTable(const PageTable& orig) {
@@ -74,11 +116,15 @@ PageTable::PageTable(const PageTable& orig) {
 PageTable::~PageTable() {
     delete[] pTable;
     delete[] fTable;
-#ifdef USEOLDALGORITHM
-    if(algorithm == OPT) delete[] next_occur;
-#else
+    delete[] frame_time;
+    delete[] frame_age;
+    delete[] next_occur;
+    delete[] sTable;
+    delete[] slow_uses;
+#ifndef USEOLDFUTURE
+    delete[] future;
 #endif
-    fclose(tracefile);
+    if(tracefile != NULL) fclose(tracefile);
 }
 
 /* 
@@ -95,24 +141,26 @@ void PageTable::pagetoframe(int page, int frame){
         std::cout << "ERR: Page Number out of bounds." << std::endl;
         return;
     }
-    if(fTable[frame] != NULL){
+    if(fTable[frame] != NO_FRAME){
         std::cout << "ERR: The frame has not been evicted" << std::endl;
         return;
     }
     
     // Now that all the checks passed, we can safely put a page into the frame.
-    fTable[frame] = pTable + page;
+    fTable[frame] = page;
     pTable[page].isReferenced = 1;
     pTable[page].frameNum = frame;
-    pTable[page].timeStamp = mem_accesses;
+    pTable[page].isValid = 1;
+    frame_age[frame] = 1;
+    frame_time[frame] = mem_accesses;
     // Update Page Table
     frames_used++;
 }
 
 /*
  * This method is used to evict a page from the specified frame.
- * There is no need to fix isReferenced or timeStamp 
- * Frame number needs to be reset for checking if it is in a frame.
+ * There is no need to fix isReferenced or the frame's timestamp and age.
+ * The valid bit needs to be reset for checking if it is in a frame.
  */
 void PageTable::evictpage(int frame){
     // First check if frame is valid
@@ -120,22 +168,86 @@ void PageTable::evictpage(int frame){
         std::cout << "ERR: The frame number is out of bounds" << std::endl;
         return;
     }
-    if(fTable[frame] == NULL){
+    if(fTable[frame] == NO_FRAME){
         std::cout << "ERR: Tried to evict frame already empty" << std::endl;
         return;
     }
-    // Update stats
-    if(fTable[frame]->isDirty) total_writes++;
+    TableEntry* entry = pTable + fTable[frame];
+    // With a slow tier the page goes there instead of to disk.
+    if(slow_frames > 0){
+        if(profiler != NULL) profiler->demote(fTable[frame]);
+        demotepage(fTable[frame]);
+    }
+    else{
+        if(profiler != NULL) profiler->evict(fTable[frame]);
+        // Update stats
+        if(entry->isDirty){
+            total_writes++;
+            if(profiler != NULL) profiler->write(fTable[frame], 1);
+        }
+        entry->isDirty = 0;
+    }
     
     // Checks have passed. Proceed to evict frame.
-    fTable[frame]->isDirty = false;
-    fTable[frame]->frameNum = NO_FRAME;
-    fTable[frame] = NULL;
+    entry->isValid = 0;
+    fTable[frame] = NO_FRAME;
     // Update Page Table
     frames_used--;
     // Update stats
 }
 
+/*
+ * Moves a page being evicted from the fast tier into the slow tier.
+ * If the slow tier is full a clock picks a page there to go to disk.
+ * The page keeps its dirty bit since it has not been written back yet.
+ */
+void PageTable::demotepage(int page){
+    int i;
+    if(slow_used < slow_frames){
+        // There is a free slow frame. Lets find it.
+        for(i = 0; sTable[i] != NO_FRAME; i++);
+    }
+    else{
+        // Second chance over the slow tier. Pages used while there get skipped once.
+        while(pTable[sTable[slow_hand]].isReferenced){
+            pTable[sTable[slow_hand]].isReferenced = 0;
+            slow_hand++;
+            if(slow_hand == slow_frames) slow_hand = 0;
+        }
+        i = slow_hand;
+        // The demoted page goes here so the hand moves past it like any clock.
+        slow_hand = (i + 1) % slow_frames;
+        // This page leaves memory completely.
+        TableEntry* victim = pTable + sTable[i];
+        if(profiler != NULL) profiler->evict(sTable[i]);
+        if(victim->isDirty){
+            total_writes++;
+            if(profiler != NULL) profiler->write(sTable[i], 1);
+        }
+        victim->isDirty = 0;
+        victim->tag = 0;
+        sTable[i] = NO_FRAME;
+        slow_used--;
+    }
+    sTable[i] = page;
+    slow_uses[i] = 0;
+    pTable[page].frameNum = i;
+    pTable[page].tag = TAG_SLOW;
+    pTable[page].isReferenced = 0;
+    slow_used++;
+    demotions++;
+}
+
+/*
+ * Takes a page out of the slow tier so it can be put in a fast frame.
+ */
+void PageTable::promotepage(int page){
+    sTable[pTable[page].frameNum] = NO_FRAME;
+    pTable[page].tag = 0;
+    slow_used--;
+    promotions++;
+}
+
 /*
  * A simple method that will set the refresh value needed
  * for 2 of the algorithm
@@ -150,6 +262,47 @@ void PageTable::setTau(int param){
     tau = param;
 }
 
+/*
+ * Turns on profiling. The profiler is not owned by the page table.
+ */
+void PageTable::setProfiler(Profiler* prof){
+    profiler = prof;
+}
+
+/*
+ * Adds a slow tier with the given number of frames.
+ * Pages evicted from the fast tier are demoted there instead of going to disk.
+ */
+void PageTable::setSlowTier(int frames){
+    delete[] sTable;
+    delete[] slow_uses;
+    slow_frames = frames;
+    sTable = new int[slow_frames];
+    slow_uses = new unsigned int[slow_frames];
+    for(int i = 0; i < slow_frames; i++){
+        sTable[i] = NO_FRAME;
+        slow_uses[i] = 0;
+    }
+}
+
+/*
+ * Sets how many accesses a page takes in the slow tier before it is promoted.
+ * 1 promotes on the first access.
+ */
+void PageTable::setPromoteAfter(int num){
+    promote_after = (num < 1) ? 1 : num;
+}
+
+/*
+ * Sets the cost of an access to each tier and to disk.
+ * Only used for the estimated access time.
+ */
+void PageTable::setAccessCosts(unsigned int fast, unsigned int slow, unsigned int disk){
+    fast_cost = fast;
+    slow_cost = slow;
+    disk_cost = disk;
+}
+
 
 #ifdef USEOLDFUTURE
 /*
@@ -164,6 +317,14 @@ int PageTable::find_future(int page){
     unsigned int fpage = 0;
     int retval = mem_accesses;
     char c = 0;
+    // With an in memory trace we can just look ahead in the records.
+    if(trace != NULL){
+        TraceRecord* recs = trace->getRecords();
+        for(int i = trace_pos + 1; i < trace->getSize(); i++){
+            if(((recs[i].adr & PAGE_ADDRESS_AND) >> 12) == page) return i + 1;
+        }
+        return -1;
+    }
     fflush(tracefile);
     position = ftell(tracefile); // Store position
     // Now that we have where we left off store, we can look into the future.
@@ -188,21 +349,40 @@ int PageTable::find_future(int page){
 /*
  * This is a second method for speeding up opt.
  * It will parse the file
- * and build a record in the page table.
+ * and record for every record where its page is used next.
  */
 void PageTable::find_future_t(){
     unsigned int adr;
     char c;
-    int thread_location = 0;
-    std::cout << "Parsing file and recording future." << std::endl;
-    while(!feof(tracefile)){
-        thread_location++;
-        fscanf(tracefile, "%x %c", &adr, &c); // Read address
+    int i;
+    int records = 0;
+    std::vector<int> next; // Grows as the file is read.
+    int* last_seen = new int[num_pages]; // The last record each page was seen at.
+    for(i = 0; i < num_pages; i++) last_seen[i] = -1;
+    if(trace == NULL) std::cout << "Parsing file and recording future." << std::endl;
+    while(true){
+        // An in memory trace has already been parsed.
+        if(trace != NULL){
+            if(records >= trace->getSize()) break;
+            adr = trace->getRecords()[records].adr;
+        }
+        else if(fscanf(tracefile, "%x %c", &adr, &c) != 2) break;
         adr = adr >> 12; // convert to page number
-        pTable[adr].q.push(thread_location);
+        // The last time we saw this page now knows its future.
+        if(last_seen[adr] != -1) next[last_seen[adr]] = records;
+        last_seen[adr] = records;
+        next.push_back(-1);
+        records++;
+    }
+    delete[] last_seen;
+    
+    future = new int[records];
+    for(i = 0; i < records; i++) future[i] = next[i];
+    next_occur = new int[num_frames];
+    if(trace == NULL){
+        std::cout << "Future Recorded!" << std::endl;
+        fseek(tracefile, 0, SEEK_SET);
     }
-    std::cout << "Future Recorded!" << std::endl;
-    fseek(tracefile, 0, SEEK_SET);
 }
 #endif
 
@@ -216,15 +396,12 @@ void PageTable::opt(int page){
 #ifdef USEOLDFUTURE
     // Does the array need initialized?
     if(next_occur == NULL) next_occur = new int[num_frames];
-#else
-    // Lets pop the pages queue.
-    pTable[page].q.pop();
 #endif
     
     // First thing to do is check to see if there is a frame available.
     if(frames_used < num_frames){
         // There is a frame available. Lets find it and put it in.
-        for(i = 0; fTable[i] != NULL; i++);
+        for(i = 0; fTable[i] != NO_FRAME; i++);
         pagetoframe(page, i); // Insert the page into that frame.
 #ifdef USEOLDFUTURE
         // Lets find how far in the future this page will be next accessed.
@@ -237,13 +414,14 @@ void PageTable::opt(int page){
         // We need to evict one.
 #ifdef USEOLDFUTURE
         // We simply look for a -1 or the largest value in next_occur.
-        for(i = 1; i < num_frames; i++){
-            if(next_occur[i] > next_occur[valid_evict]){
+        // The -1 has to be checked first since it is smaller than any real future.
+        for(i = 0; i < num_frames; i++){
+            if(next_occur[i] == -1){
                 valid_evict = i;
+                break;
             }
-            else if(next_occur[i] = -1){
+            else if(next_occur[i] > next_occur[valid_evict]){
                 valid_evict = i;
-                break;
             }
         }
         // Evict the frame
@@ -254,16 +432,14 @@ void PageTable::opt(int page){
         next_occur[valid_evict] = find_future(page);
 #else
         valid_evict = -1;
-        // This is easy, we search the inverted page table for the largest next occurance.
-        // If we find that the value is null, we will sleep the main thread.
-        // Unless however, the future thread has finished.
+        // This is easy, we search the future table for the largest next occurance.
         for(i = 0; i < num_frames; i++){
-            // If the queue is empty, then all occurances of that page are done and we can evict.
-            if(fTable[i]->q.empty()){
+            // If there is no next use, then all occurances of that page are done and we can evict.
+            if(next_occur[i] == -1){
                 valid_evict = i;
                 break;
-            } // If an element is in the queue, we check against the other queue elements.
-            else if(valid_evict == -1 || fTable[i]->q.front() > fTable[valid_evict]->q.front()){
+            } // Otherwise we check against the other frames.
+            else if(valid_evict == -1 || next_occur[i] > next_occur[valid_evict]){
                 valid_evict = i;
             }
         }
@@ -274,6 +450,10 @@ void PageTable::opt(int page){
         
 #endif
     }
+#ifndef USEOLDFUTURE
+    // The frame now waits for this page's next use.
+    next_occur[pTable[page].frameNum] = future[trace_pos];
+#endif
 }
 
 /* This is the clcok algorithm 
@@ -282,11 +462,10 @@ void PageTable::opt(int page){
 void PageTable::notworking_clock(int page){
     int i;
     int valid_page;
-    static int curr = 0; // Clock algorithm index.
     // First thing to do is check to see if there is a frame available.
     if(frames_used < num_frames){
         // There is a frame available. Lets find it and put it in.
-        for(i = 0; fTable[i] != NULL; i++);
+        for(i = 0; fTable[i] != NO_FRAME; i++);
         pagetoframe(page, i); // Insert the page into that frame.
     }
     else{
@@ -295,19 +474,19 @@ void PageTable::notworking_clock(int page){
         // We will simply use the array as the clock.
         bool foundValid = false;
         while(!foundValid){
-            if(fTable[curr]->isReferenced){
+            if(pTable[fTable[clock_hand]].isReferenced){
                 // The page had been referenced. Unreferencing.
-                fTable[curr]->isReferenced = 0;
+                pTable[fTable[clock_hand]].isReferenced = 0;
             }
             else{
                 // The page is a valid choice for replacing.
-                valid_page = curr;
+                valid_page = clock_hand;
                 foundValid = true;
             }
             // Advance the clock
-            curr++;
+            clock_hand++;
             // Do we need to cycle around?
-            if(curr == num_frames) curr = 0; 
+            if(clock_hand == num_frames) clock_hand = 0; 
         }
         // Now that we found the page to evict, lets do that.
         evictpage(valid_page);
@@ -327,20 +506,17 @@ void PageTable::aging(int page){
     int valid_evict = -1;
     // First thing we need to do is iterate the time for everyone if refresh is up.
     if((mem_accesses - age) >= parameter){
-        for(i = 0; i < num_frames; i++){
-            if(fTable[i] != NULL){ // If a page exists in the frame. shift right the reference bit.
-                fTable[i]->isReferenced = fTable[i]->isReferenced >> 1;
-            }
-        }
+        // Empty frames get shifted too. Their age is reset when a page goes in.
+        for(i = 0; i < num_frames; i++) frame_age[i] = frame_age[i] >> 1;
         age = mem_accesses;
     }
     // Next thing to do is check to see if there is a frame available.
     if(frames_used < num_frames){
         // There is a frame available. Lets find it and put it in.
-        for(i = 0; fTable[i] != NULL; i++);
+        for(i = 0; fTable[i] != NO_FRAME; i++);
         pagetoframe(page, i); // Insert the page into that frame.
         // Next algorithm specific add a bit to the end.
-        fTable[i]->isReferenced |= REF_END_BIT;
+        frame_age[i] |= REF_END_BIT;
         
     }
     else{
@@ -348,7 +524,7 @@ void PageTable::aging(int page){
         // We need to evict one.
         // We need to iterate through and find which frame to evict
         for(i = 0; i < num_frames; i++){
-            if(valid_evict == -1 || fTable[i]->isReferenced < fTable[valid_evict]->isReferenced)
+            if(valid_evict == -1 || frame_age[i] < frame_age[valid_evict])
                 valid_evict = i;
         }
         evictpage(valid_evict); // Evict that page
@@ -356,7 +532,7 @@ void PageTable::aging(int page){
         // Now page to frame will set isReferenced to one.
         // This will not hurt anything since it will be shifted off anyway.
         // However, we do need to still add on the end bit.
-        fTable[valid_evict]->isReferenced |= REF_END_BIT;
+        frame_age[valid_evict] |= REF_END_BIT;
         
     }
     
@@ -370,7 +546,6 @@ void PageTable::aging(int page){
  */
 void PageTable::working_clock(int page){
     int i;
-    static int curr = 0; // The clock hand.
     int valid_page; // The stored valid page.
     int no_choice = -1; // In case of a cycle.
     // This method required a modifier to be set.
@@ -378,8 +553,8 @@ void PageTable::working_clock(int page){
     // Update reference from fresh
     if((mem_accesses - age) >= parameter){
         for(i = 0; i < num_frames; i++){
-            if(fTable[i] != NULL){ // If a page exists in the frame. set reference bit to 0
-                fTable[i]->isReferenced = 0;
+            if(fTable[i] != NO_FRAME){ // If a page exists in the frame. set reference bit to 0
+                pTable[fTable[i]].isReferenced = 0;
             }
         }
         age = mem_accesses;
@@ -387,41 +562,43 @@ void PageTable::working_clock(int page){
     // First thing to do is check to see if there is a frame available.
     if(frames_used < num_frames){
         // There is a frame available. Lets find it and put it in.
-        for(i = 0; fTable[i] != NULL; i++);
+        for(i = 0; fTable[i] != NO_FRAME; i++);
         pagetoframe(page, i); // Insert the page into that frame.
     }
     else{
         // The frames are all full.
         // We need to evict one.
-        int hasCycled = curr;
+        int hasCycled = clock_hand;
+        int laps = 0; // Full trips of the hand around the frames.
         bool foundValid = false;
         do{
+            TableEntry* entry = pTable + fTable[clock_hand];
             // Is the reference bit set?
-            if(fTable[curr]->isReferenced == 1){
+            if(entry->isReferenced == 1){
                 // The page was in use, we should not evict.
                 // We should update properties.
-                fTable[curr]->isReferenced = 0;
-                fTable[curr]->timeStamp = mem_accesses;
+                entry->isReferenced = 0;
+                frame_time[clock_hand] = mem_accesses;
             }
             else{
                 // The reference bit was not set.
                 // Is the age within tau to evict?
-                if((mem_accesses - fTable[curr]->timeStamp) > tau){
+                if((mem_accesses - frame_time[clock_hand]) > tau){
                     // This means the age is outside the working set.
                     // However we need to check if it is dirty.
-                    if(fTable[curr]->isDirty){
+                    if(entry->isDirty){
                         // Undirty it
-                        fTable[curr]->isDirty = false;
+                        entry->isDirty = 0;
                         // The page was dirty. check if it was the worst age
                         if(no_choice == -1 ||
-                                fTable[curr]->timeStamp < fTable[no_choice]->timeStamp){
+                                frame_time[clock_hand] < frame_time[no_choice]){
                             // This was the oldest age.
-                            no_choice = curr;
+                            no_choice = clock_hand;
                         }
                     }
                     else{
                         // The page was clean so we can easily replace it
-                        valid_page = curr;
+                        valid_page = clock_hand;
                         foundValid = true;
                     }
                 }
@@ -430,16 +607,19 @@ void PageTable::working_clock(int page){
                     // However, we are going to see which is the oldest incase all pages
                     // seem to be in the working set.
                     if(no_choice == -1 ||
-                            fTable[curr]->timeStamp < fTable[no_choice]->timeStamp){
+                            frame_time[clock_hand] < frame_time[no_choice]){
                         // This was the oldest age.
-                        no_choice = curr;
+                        no_choice = clock_hand;
                     }
                 }
             }
-            // Next we need to iterate curr;
-            curr++;
-            if(curr >= num_frames) curr = 0;
-        } while((hasCycled != curr && !foundValid) || no_choice == -1);
+            // Next we need to iterate clock_hand;
+            clock_hand++;
+            if(clock_hand >= num_frames) clock_hand = 0;
+            // After two laps every referenced page has been cleared and seen again.
+            // If nothing is a fallback by now, nothing ever will be and we would spin forever.
+            if(hasCycled == clock_hand && ++laps >= 2 && foundValid) break;
+        } while((hasCycled != clock_hand && !foundValid) || no_choice == -1);
         
         // Did we encounter a cycle?
         if(!foundValid){
@@ -462,7 +642,6 @@ void PageTable::working_clock(int page){
  */
 void PageTable::useAddress(unsigned int adr, bool isWriting){
     int i;
-    static unsigned int prev =  0;
     // Lets convert the address to a page number.
     unsigned int page_num = adr & PAGE_ADDRESS_AND; // And off the offset
     page_num = page_num >> 12; // Shift the page number to be correct
@@ -470,15 +649,32 @@ void PageTable::useAddress(unsigned int adr, bool isWriting){
     // Then lets iterate the a stat.
     mem_accesses++;
 
-    prev = adr;
     // Iterate Writes if necessary
     if(isWriting) total_writes++;
     
+    // Only costs a check when profiling is off.
+    if(profiler != NULL){
+        profiler->access(page_num, 1);
+        if(isWriting) profiler->write(page_num, 1);
+    }
+    
     // Is the page already in a frame?
-    if(pTable[page_num].frameNum == NO_FRAME){
-        // Page Fault
-        // iterate stat
-        page_faults++;
+    if(!pTable[page_num].isValid){
+        if(pTable[page_num].tag == TAG_SLOW){
+            // The page is in the slow tier so there is no trip to disk.
+            slow_hits++;
+            if(profiler != NULL) profiler->slowHit(page_num);
+            pTable[page_num].isReferenced = 1;
+            // It stays there until it has been used enough.
+            if(++slow_uses[pTable[page_num].frameNum] < (unsigned int)promote_after) return;
+            promotepage(page_num);
+        }
+        else{
+            // Page Fault
+            // iterate stat
+            page_faults++;
+            if(profiler != NULL) profiler->fault(page_num);
+        }
         // Lets send the page number to the correct algorithm.
         switch(algorithm){
             case OPT:
@@ -500,16 +696,13 @@ void PageTable::useAddress(unsigned int adr, bool isWriting){
     else{
         // This is for aging algorithm as to iterate all the reference bits.
         if(algorithm == AGING && (mem_accesses - age) >= parameter){
-            for(i = 0; i < num_frames; i++){
-                if(fTable[i] != NULL) // If a page exists in the frame. shift right the reference bit.
-                    fTable[i]->isReferenced = fTable[i]->isReferenced >> 1;
-            }
-            pTable[page_num].isReferenced |= REF_END_BIT;
+            for(i = 0; i < num_frames; i++) frame_age[i] = frame_age[i] >> 1;
+            frame_age[pTable[page_num].frameNum] |= REF_END_BIT;
             // Update age
             age = mem_accesses;
         }
         else if(algorithm == AGING){
-            pTable[page_num].isReferenced |= REF_END_BIT;
+            frame_age[pTable[page_num].frameNum] |= REF_END_BIT;
         }
         // This is for OPT algorithm
         else if(algorithm == OPT){
@@ -518,15 +711,15 @@ void PageTable::useAddress(unsigned int adr, bool isWriting){
             // Then we need to update the next occurance to be even further. 
             next_occur[pTable[page_num].frameNum] = find_future(page_num);
 #else
-            // If a hit occurs, we simply deque it from the queue.
-            pTable[page_num].q.pop();
+            // If a hit occurs, the frame now waits for the page's next use.
+            next_occur[pTable[page_num].frameNum] = future[trace_pos];
 #endif
         }
         else{
             if((mem_accesses - age) >= parameter){
                 for(i = 0; i < num_frames; i++){
-                    if(fTable[i] != NULL){ // If a page exists in the frame. set reference bit to 0;
-                        fTable[i]->isReferenced = 0;
+                    if(fTable[i] != NO_FRAME){ // If a page exists in the frame. set reference bit to 0;
+                        pTable[fTable[i]].isReferenced = 0;
                     }
                 }
                 age = mem_accesses;
@@ -537,6 +730,69 @@ void PageTable::useAddress(unsigned int adr, bool isWriting){
     
 }
 
+/*
+ * Uses the same address count times in a row.
+ * This ends up the same as calling useAddress count times.
+ * Once the page is in a fast frame the rest are hits.
+ * So for those we only need to catch up the stats and the refreshes
+ * that would have happened over them.
+ */
+void PageTable::useAddressRun(unsigned int adr, unsigned int count, unsigned int writes){
+    int i;
+    unsigned int page_num = (adr & PAGE_ADDRESS_AND) >> 12;
+    unsigned int rest = count - 1; // Accesses after the first.
+    unsigned int refreshes = 0; // Refreshes that happen during the rest.
+    // The first access is handled like any other.
+    useAddress(adr, false);
+    total_writes += writes;
+    if(profiler != NULL) profiler->write(page_num, writes);
+    
+    // Until the page is in a fast frame every access has to be taken one at a time.
+    // The algorithm may not have placed it or it may still be in the slow tier.
+    for(; rest > 0 && !pTable[page_num].isValid; rest--) useAddress(adr, false);
+    if(rest == 0) return;
+    
+    // A refresh happens once mem_accesses - age reaches the parameter. Then age resets.
+    if(algorithm != OPT){
+        unsigned long long period = (unsigned int)parameter;
+        unsigned long long since = mem_accesses - age;
+        unsigned long long first; // Which of the rest sees the first refresh.
+        if(period == 0) period = 1;
+        first = (since + 1 >= period) ? 1 : period - since;
+        if(first <= rest){
+            refreshes = 1 + (rest - first) / period;
+            age = mem_accesses + first + (refreshes - 1) * period;
+        }
+    }
+    mem_accesses += rest;
+    if(profiler != NULL) profiler->access(page_num, rest);
+    
+    switch(algorithm){
+        case OPT:
+            // The future has one entry per record so it has already moved on.
+            break;
+        case AGING:{
+            // After 8 shifts everything is gone anyway.
+            if(refreshes > 8) refreshes = 8;
+            unsigned char bits = 0; // The end bits the page gets back after each shift.
+            for(unsigned int k = 0; k < refreshes; k++) bits = (bits >> 1) | REF_END_BIT;
+            if(refreshes > 0){
+                for(i = 0; i < num_frames; i++) frame_age[i] = frame_age[i] >> refreshes;
+            }
+            frame_age[pTable[page_num].frameNum] |= bits | REF_END_BIT;
+            break;
+        }
+        default:
+            if(refreshes > 0){
+                for(i = 0; i < num_frames; i++){
+                    if(fTable[i] != NO_FRAME) pTable[fTable[i]].isReferenced = 0;
+                }
+            }
+            pTable[page_num].isReferenced = 1;
+            break;
+    }
+}
+
 /*
  * This method starts the main loop to begin reading in addresses
  * It will read an address and call useAddress
@@ -545,13 +801,29 @@ void PageTable::beginFileTraverse(){
     unsigned int adr;
     char mode;
     bool foundEOF = false;
+#ifndef USEOLDFUTURE
+    // Initial recording of future.
+    // Done here and not in the constructor so a cached result never has to parse the trace.
+    if(algorithm == OPT) find_future_t();
+#endif
+    // An in memory trace just needs to be walked.
+    if(trace != NULL){
+        TraceRecord* recs = trace->getRecords();
+        for(trace_pos = 0; trace_pos < trace->getSize(); trace_pos++){
+            useAddressRun(recs[trace_pos].adr, recs[trace_pos].count, recs[trace_pos].writes);
+        }
+        return;
+    }
     while(!foundEOF){
         fscanf(tracefile, "%x %c", &adr, &mode);
         /*std::cout.setf(std::ios::hex, std::ios::basefield);
         std::cout << "Read: " << adr;
         std::cout.unsetf(std::ios::hex);
         std::cout << " " << mode << std::endl;*/
-        if(!feof(tracefile))useAddress(adr, (mode == 'W' || mode == 'w'));
+        if(!feof(tracefile)){
+            useAddress(adr, (mode == 'W' || mode == 'w'));
+            trace_pos++;
+        }
         else foundEOF = true;
     }
 }
@@ -581,8 +853,56 @@ void PageTable::printTrace(){
     std::cout << "Total Memory Accesses: " << mem_accesses << std::endl;
     std::cout << "Total Page Faults: " << page_faults << std::endl;
     std::cout << "Total Writes to Disk: " << total_writes << std::endl;
+    if(slow_frames > 0){
+        unsigned int fast_hits = mem_accesses - slow_hits - page_faults;
+        unsigned long long est = (unsigned long long)fast_hits * fast_cost +
+                (unsigned long long)slow_hits * slow_cost + (unsigned long long)page_faults * disk_cost;
+        std::cout << "Number of Slow Tier Frames: " << slow_frames << std::endl;
+        std::cout << "Fast Tier Hits: " << fast_hits << std::endl;
+        std::cout << "Slow Tier Hits: " << slow_hits << std::endl;
+        std::cout << "Promotions: " << promotions << std::endl;
+        std::cout << "Demotions: " << demotions << std::endl;
+        std::cout << "Estimated Access Time (ns): " << est << std::endl;
+    }
 }
 
 bool PageTable::isFileOpen(){
     return (tracefile != NULL);
-}
\ No newline at end of file
+}
+
+/*
+ * Copies out every stat a run produces.
+ */
+void PageTable::getStats(RunStats* stats){
+    stats->mem_accesses = mem_accesses;
+    stats->page_faults = page_faults;
+    stats->total_writes = total_writes;
+    stats->slow_hits = slow_hits;
+    stats->promotions = promotions;
+    stats->demotions = demotions;
+}
+
+/*
+ * Puts in the stats of a run done before so printTrace can show them.
+ * Used in place of beginFileTraverse.
+ */
+void PageTable::loadStats(RunStats* stats){
+    mem_accesses = stats->mem_accesses;
+    page_faults = stats->page_faults;
+    total_writes = stats->total_writes;
+    slow_hits = stats->slow_hits;
+    promotions = stats->promotions;
+    demotions = stats->demotions;
+}
+
+int PageTable::getPageFaults(){
+    return page_faults;
+}
+
+unsigned int PageTable::getMemAccesses(){
+    return mem_accesses;
+}
+
+int PageTable::getTotalWrites(){
+    return total_writes;
+}
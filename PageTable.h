@@ -9,7 +9,8 @@
 #define	PAGETABLE_H
 #include <cstdlib>
 #include <cstdio>
-#include <queue>
+#include "Trace.h"
+#include "Profiler.h"
 #define PAGE_SIZE 4096
 #define PAGE_ADDRESS_AND 0xFFFFF000
 #define OPT 0
@@ -18,28 +19,60 @@
 #define WORKING_SET_CLOCK 3
 #define REF_END_BIT 0x80
 #define NO_FRAME -1
+#define TAG_SLOW 1 // Tag for a page sitting in the slow tier.
+#define FAST_COST 100 // Default cost in ns of an access to the fast tier.
+#define SLOW_COST 1000 // Default cost in ns of an access to the slow tier.
+#define DISK_COST 10000000 // Default cost in ns of going to disk.
 
+/*
+ * A page table entry packed into 4 bytes.
+ * Every access looks one of these up so it only holds what the hit path needs.
+ * Anything only needed for pages in memory is kept per frame instead.
+ */
 typedef struct TableEntry{
-    bool isDirty; // Dirty Bit
-    int frameNum; // Frame Number
-    unsigned int timeStamp; // Timestamp for certain algorithms.
-    unsigned char isReferenced; // Reference bit. Set as int for aging algorithm
-    std::queue<int> q; // For the opt algorithm. Otherwise wont be used.
+    unsigned int frameNum : 24; // Frame Number. Only means something if isValid is set or the page is in the slow tier.
+    unsigned int isValid : 1; // Is the page in a frame.
+    unsigned int isDirty : 1; // Dirty Bit
+    unsigned int isReferenced : 1; // Reference bit. The aging counter is kept per frame.
+    unsigned int tag : 5; // Tags the page. TAG_SLOW if it is in a slow tier frame.
 } TableEntry;
 
+/*
+ * Every stat a run produces. Enough to print the results again later.
+ */
+typedef struct RunStats{
+    unsigned int mem_accesses;
+    int page_faults;
+    int total_writes;
+    unsigned int slow_hits;
+    int promotions;
+    int demotions;
+} RunStats;
+
 class PageTable {
 public:
     PageTable(int, int, char*);
+    PageTable(int, int, Trace*);
     PageTable(const PageTable& orig);
     virtual ~PageTable();
     int getPageFaults();
+    unsigned int getMemAccesses();
+    int getTotalWrites();
+    void getStats(RunStats*);
+    void loadStats(RunStats*);
     void useAddress(unsigned int, bool);
+    void useAddressRun(unsigned int, unsigned int, unsigned int);
     void printTrace();
     void beginFileTraverse();
     void setRefresh(int);
     void setTau(int);
+    void setSlowTier(int);
+    void setPromoteAfter(int);
+    void setAccessCosts(unsigned int, unsigned int, unsigned int);
+    void setProfiler(Profiler*);
     bool isFileOpen();
 private:
+    void init(int, int);
 #ifdef USEOLDFUTURE
     int find_future(int);
 #else
@@ -51,8 +84,13 @@ private:
     void working_clock(int);
     void pagetoframe(int, int);
     void evictpage(int);
+    void demotepage(int);
+    void promotepage(int);
     int page_faults; // Stat variable
     FILE* tracefile; // File pointer for reading.
+    Trace* trace; // In memory trace. Used instead of the file when set.
+    int trace_pos; // The record of the trace being used.
+    Profiler* profiler; // Attributes stats to pages. NULL unless profiling.
     unsigned int mem_accesses; // Stat variable
     int total_writes; // Stat variable
     int num_frames; // Number of physical memory frames.
@@ -63,11 +101,26 @@ private:
     int frames_used; // Used for the start as to see how many frames are in use.
     int parameter; // Used for Working Set/Aging. It is the extra parameter.
     int age; // This is used for the aging algorithm to update after a number of writes.
+    int clock_hand; // The clock hand for the clock algorithms.
+    int slow_frames; // Number of frames in the slow tier. 0 if there is no slow tier.
+    int slow_used; // How many slow tier frames are in use.
+    int slow_hand; // The clock hand for the slow tier.
+    int promote_after; // Accesses in the slow tier before a page is promoted.
+    unsigned int fast_cost; // Access costs for the estimated time.
+    unsigned int slow_cost;
+    unsigned int disk_cost;
+    unsigned int slow_hits; // Stat variable
+    int promotions; // Stat variable
+    int demotions; // Stat variable
     TableEntry* pTable; // The page table itself.
-    TableEntry** fTable; // The inverted Page Table.
-#ifdef USEOLDFUTURE
-    int* next_occur; // The future table. Only used with OPT
-#else
+    int* fTable; // The inverted Page Table. The page in each frame or NO_FRAME.
+    unsigned int* frame_time; // Timestamp of each frame for the working set clock.
+    unsigned char* frame_age; // The 8-bit aging counter of each frame.
+    int* sTable; // The inverted table for the slow tier.
+    unsigned int* slow_uses; // Accesses to each slow tier frame since it was demoted.
+    int* next_occur; // The future table. When each frame is next used. Only used with OPT
+#ifndef USEOLDFUTURE
+    int* future; // For each record, the next record using the same page. -1 if none.
 #endif
 };
 
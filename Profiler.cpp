@@ -0,0 +1,236 @@
+/* 
+ * File:   Profiler.cpp
+ * Author: jacob
+ * 
+ * Created on October 19, 2026, 3:40 PM
+ */
+
+#include "Profiler.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+/*
+ * Constructor
+ * 
+ * int slots - the most keys the sketch will keep
+ */
+SpaceSaving::SpaceSaving(int slots) {
+    capacity = (slots < 1) ? 1 : slots;
+    used = 0;
+    keys = new unsigned int[capacity];
+    counts = new unsigned int[capacity];
+    errors = new unsigned int[capacity];
+}
+
+SpaceSaving::~SpaceSaving() {
+    delete[] keys;
+    delete[] counts;
+    delete[] errors;
+}
+
+/*
+ * Swaps two heap slots and keeps the key lookup right.
+ */
+void SpaceSaving::swap_slots(int a, int b){
+    std::swap(keys[a], keys[b]);
+    std::swap(counts[a], counts[b]);
+    std::swap(errors[a], errors[b]);
+    where[keys[a]] = a;
+    where[keys[b]] = b;
+}
+
+void SpaceSaving::sift_up(int i){
+    while(i > 0 && counts[(i - 1) / 2] > counts[i]){
+        swap_slots(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+void SpaceSaving::sift_down(int i){
+    while(true){
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+        if(left < used && counts[left] < counts[smallest]) smallest = left;
+        if(right < used && counts[right] < counts[smallest]) smallest = right;
+        if(smallest == i) return;
+        swap_slots(i, smallest);
+        i = smallest;
+    }
+}
+
+/*
+ * Adds weight to a key.
+ * If the key is not kept and there is no room it takes over the smallest count.
+ */
+void SpaceSaving::add(unsigned int key, unsigned int weight){
+    std::unordered_map<unsigned int, int>::iterator it = where.find(key);
+    if(it != where.end()){
+        // Counts only go up so it can only need to move down the heap.
+        counts[it->second] += weight;
+        sift_down(it->second);
+    }
+    else if(used < capacity){
+        keys[used] = key;
+        counts[used] = weight;
+        errors[used] = 0;
+        where[key] = used;
+        used++;
+        sift_up(used - 1);
+    }
+    else{
+        // Take over the smallest key. Its count becomes our error.
+        where.erase(keys[0]);
+        keys[0] = key;
+        errors[0] = counts[0];
+        counts[0] += weight;
+        where[key] = 0;
+        sift_down(0);
+    }
+}
+
+/*
+ * Fills in the k largest keys, counts and errors from largest down.
+ * Returns how many were filled in.
+ */
+int SpaceSaving::top(int k, unsigned int* out_keys, unsigned int* out_counts, unsigned int* out_errors){
+    std::vector<std::pair<unsigned int, int> > order;
+    for(int i = 0; i < used; i++) order.push_back(std::make_pair(counts[i], i));
+    std::sort(order.rbegin(), order.rend());
+    if(k > used) k = used;
+    for(int i = 0; i < k; i++){
+        out_keys[i] = keys[order[i].second];
+        out_counts[i] = counts[order[i].second];
+        out_errors[i] = errors[order[i].second];
+    }
+    return k;
+}
+
+/*
+ * Constructor
+ * 
+ * int k - how many of the top pages and regions to report
+ */
+Profiler::Profiler(int k) {
+    top_k = (k < 1) ? 1 : k;
+    page_accesses = new SpaceSaving(top_k * SLOTS_PER_K);
+    page_faults = new SpaceSaving(top_k * SLOTS_PER_K);
+    page_writes = new SpaceSaving(top_k * SLOTS_PER_K);
+    page_evictions = new SpaceSaving(top_k * SLOTS_PER_K);
+    page_demotions = new SpaceSaving(top_k * SLOTS_PER_K);
+    page_slow_hits = new SpaceSaving(top_k * SLOTS_PER_K);
+    region_accesses = new unsigned int[NUM_REGIONS];
+    region_faults = new unsigned int[NUM_REGIONS];
+    region_writes = new unsigned int[NUM_REGIONS];
+    region_evictions = new unsigned int[NUM_REGIONS];
+    region_demotions = new unsigned int[NUM_REGIONS];
+    region_slow_hits = new unsigned int[NUM_REGIONS];
+    memset(region_accesses, 0, NUM_REGIONS * sizeof(unsigned int));
+    memset(region_faults, 0, NUM_REGIONS * sizeof(unsigned int));
+    memset(region_writes, 0, NUM_REGIONS * sizeof(unsigned int));
+    memset(region_evictions, 0, NUM_REGIONS * sizeof(unsigned int));
+    memset(region_demotions, 0, NUM_REGIONS * sizeof(unsigned int));
+    memset(region_slow_hits, 0, NUM_REGIONS * sizeof(unsigned int));
+    tiered = false;
+}
+
+Profiler::~Profiler() {
+    delete page_accesses;
+    delete page_faults;
+    delete page_writes;
+    delete page_evictions;
+    delete page_demotions;
+    delete page_slow_hits;
+    delete[] region_accesses;
+    delete[] region_faults;
+    delete[] region_writes;
+    delete[] region_evictions;
+    delete[] region_demotions;
+    delete[] region_slow_hits;
+}
+
+/*
+ * These are called by the page table as things happen to a page.
+ */
+void Profiler::access(unsigned int page, unsigned int count){
+    page_accesses->add(page, count);
+    region_accesses[page >> (REGION_SHIFT - 12)] += count;
+}
+
+void Profiler::fault(unsigned int page){
+    page_faults->add(page, 1);
+    region_faults[page >> (REGION_SHIFT - 12)]++;
+}
+
+void Profiler::write(unsigned int page, unsigned int count){
+    if(count == 0) return;
+    page_writes->add(page, count);
+    region_writes[page >> (REGION_SHIFT - 12)] += count;
+}
+
+void Profiler::evict(unsigned int page){
+    page_evictions->add(page, 1);
+    region_evictions[page >> (REGION_SHIFT - 12)]++;
+}
+
+void Profiler::demote(unsigned int page){
+    tiered = true;
+    page_demotions->add(page, 1);
+    region_demotions[page >> (REGION_SHIFT - 12)]++;
+}
+
+void Profiler::slowHit(unsigned int page){
+    page_slow_hits->add(page, 1);
+    region_slow_hits[page >> (REGION_SHIFT - 12)]++;
+}
+
+/*
+ * Prints the top pages from one of the sketches.
+ */
+void Profiler::print_pages(const char* title, SpaceSaving* sketch){
+    unsigned int* keys = new unsigned int[top_k];
+    unsigned int* counts = new unsigned int[top_k];
+    unsigned int* errors = new unsigned int[top_k];
+    int found = sketch->top(top_k, keys, counts, errors);
+    printf("Top %d pages by %s:\n", top_k, title);
+    printf("%12s %12s %12s\n", "Page", "Count", "Error");
+    for(int i = 0; i < found; i++) printf("  0x%08x %12u %12u\n", keys[i] << 12, counts[i], errors[i]);
+    delete[] keys;
+    delete[] counts;
+    delete[] errors;
+}
+
+/*
+ * Prints the hottest and most thrashed pages and the regions with the most faults.
+ */
+void Profiler::printProfile(){
+    int i;
+    print_pages("accesses", page_accesses);
+    print_pages("faults", page_faults);
+    print_pages("evictions", page_evictions);
+    print_pages("writes", page_writes);
+    if(tiered){
+        print_pages("demotions", page_demotions);
+        print_pages("slow tier hits", page_slow_hits);
+    }
+    
+    // Regions are counted exactly so just sort them.
+    std::vector<std::pair<unsigned int, int> > order;
+    for(i = 0; i < NUM_REGIONS; i++){
+        if(region_accesses[i] > 0) order.push_back(std::make_pair(region_faults[i], i));
+    }
+    std::sort(order.rbegin(), order.rend());
+    printf("Top %d %dKB regions by faults:\n", top_k, (1 << REGION_SHIFT) / 1024);
+    printf("%12s %12s %12s %12s %12s", "Region", "Accesses", "Faults", "Writes", "Evictions");
+    if(tiered) printf(" %12s %12s", "Demotions", "Slow hits");
+    printf("\n");
+    for(i = 0; i < top_k && i < (int)order.size(); i++){
+        int r = order[i].second;
+        printf("  0x%08x %12u %12u %12u %12u", (unsigned int)r << REGION_SHIFT, region_accesses[r],
+                region_faults[r], region_writes[r], region_evictions[r]);
+        if(tiered) printf(" %12u %12u", region_demotions[r], region_slow_hits[r]);
+        printf("\n");
+    }
+}
@@ -0,0 +1,77 @@
+/* 
+ * File:   Profiler.h
+ * Author: jacob
+ *
+ * Created on October 19, 2026, 3:40 PM
+ */
+
+#ifndef PROFILER_H
+#define	PROFILER_H
+#include <unordered_map>
+#define REGION_SHIFT 20 // Regions are 1MB of address space.
+#define NUM_REGIONS (1 << (32 - REGION_SHIFT))
+#define SLOTS_PER_K 10 // Sketch slots kept for every page reported.
+
+/*
+ * The Space-Saving heavy hitter sketch.
+ * Keeps counts for at most a fixed number of keys.
+ * When a new key comes in and it is full, the smallest count is taken over.
+ * Any key with more than total / slots is always kept.
+ * A count is never under the real count and never over it by more than its error.
+ */
+class SpaceSaving {
+public:
+    SpaceSaving(int);
+    virtual ~SpaceSaving();
+    void add(unsigned int, unsigned int);
+    int top(int, unsigned int*, unsigned int*, unsigned int*);
+private:
+    void swap_slots(int, int);
+    void sift_up(int);
+    void sift_down(int);
+    int capacity; // Most keys that can be kept.
+    int used; // Keys being kept.
+    unsigned int* keys; // A min heap on counts.
+    unsigned int* counts;
+    unsigned int* errors; // How much of the count could belong to keys it took over.
+    std::unordered_map<unsigned int, int> where; // Key to its place in the heap.
+};
+
+/*
+ * Attributes accesses, faults, writes and evictions to pages and regions.
+ * With a slow tier an eviction is a page leaving memory. Pages moved down
+ * to the slow tier and hits there are counted on their own.
+ * Pages go through sketches so memory stays bounded.
+ * Regions are few enough to count exactly.
+ */
+class Profiler {
+public:
+    Profiler(int);
+    virtual ~Profiler();
+    void access(unsigned int, unsigned int);
+    void fault(unsigned int);
+    void write(unsigned int, unsigned int);
+    void evict(unsigned int);
+    void demote(unsigned int);
+    void slowHit(unsigned int);
+    void printProfile();
+private:
+    void print_pages(const char*, SpaceSaving*);
+    int top_k; // How many pages and regions to report.
+    SpaceSaving* page_accesses;
+    SpaceSaving* page_faults;
+    SpaceSaving* page_writes;
+    SpaceSaving* page_evictions;
+    SpaceSaving* page_demotions;
+    SpaceSaving* page_slow_hits;
+    unsigned int* region_accesses; // Exact counts for each region.
+    unsigned int* region_faults;
+    unsigned int* region_writes;
+    unsigned int* region_evictions;
+    unsigned int* region_demotions;
+    unsigned int* region_slow_hits;
+    bool tiered; // Was anything demoted. The slow tier tables are only printed if so.
+};
+
+#endif	/* PROFILER_H */
+
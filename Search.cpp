@@ -0,0 +1,346 @@
+/* 
+ * File:   Search.cpp
+ * Author: jacob
+ * 
+ * Created on October 19, 2026, 1:05 PM
+ */
+
+#include "Search.h"
+#include "PageTable.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+
+/*
+ * Runs a single point of the search on its own page table.
+ * Each probe gets its own table so probes can run side by side.
+ */
+static void run_point(Trace* trace, int alg, SearchPoint* p){
+    PageTable* pt = new PageTable(p->frames, alg, trace);
+    if(p->refresh != -1) pt->setRefresh(p->refresh);
+    if(p->tau != -1) pt->setTau(p->tau);
+    pt->beginFileTraverse();
+    p->mem_accesses = pt->getMemAccesses();
+    p->page_faults = pt->getPageFaults();
+    p->total_writes = pt->getTotalWrites();
+    delete pt;
+}
+
+/*
+ * Works out the fault rate once the stats are in.
+ */
+static void set_rate(SearchPoint* p){
+    if(p->mem_accesses == 0) p->fault_rate = 0;
+    else p->fault_rate = (double)p->page_faults / p->mem_accesses;
+}
+
+/*
+ * Orders points by frames then refresh then tau for printing.
+ */
+static bool point_less(const SearchPoint& a, const SearchPoint& b){
+    if(a.frames != b.frames) return a.frames < b.frames;
+    if(a.refresh != b.refresh) return a.refresh < b.refresh;
+    return a.tau < b.tau;
+}
+
+/*
+ * Constructor
+ * 
+ * Trace* tr     - The loaded trace every probe runs over
+ * int alg       - The algorithm to search
+ * double target - The largest faults per access that is acceptable
+ */
+Search::Search(Trace* tr, int alg, double tgt) {
+    trace = tr;
+    algorithm = alg;
+    target = tgt;
+    max_frames = -1;
+    refresh = -1;
+    tau = -1;
+    jobs = std::thread::hardware_concurrency();
+    if(jobs < 1) jobs = 1;
+    cache = NULL;
+    trace_hash = 0;
+    found = false;
+    
+    // Coordinate search starts in the middle of the grid.
+    start.frames = 0;
+    start.refresh = -1;
+    start.tau = -1;
+    if(algorithm == AGING || algorithm == WORKING_SET_CLOCK) start.refresh = 1024;
+    if(algorithm == WORKING_SET_CLOCK) start.tau = 1024;
+    best = start;
+}
+
+Search::~Search() {
+}
+
+/*
+ * Sets the upper bound of the frame search.
+ * Without one the number of pages in the trace is used.
+ */
+void Search::setMaxFrames(int frames){
+    max_frames = frames;
+}
+
+/*
+ * Pins the refresh so it will not be searched.
+ */
+void Search::setRefresh(int param){
+    refresh = param;
+}
+
+/*
+ * Pins tau so it will not be searched.
+ */
+void Search::setTau(int param){
+    tau = param;
+}
+
+/*
+ * Sets how many probes can run at the same time.
+ */
+void Search::setJobs(int num){
+    jobs = (num < 1) ? 1 : num;
+}
+
+/*
+ * Uses a result cache. Points in it are not run again
+ * and every point that is run gets added to it.
+ * 
+ * ResultCache* rc - the cache
+ * unsigned long long hash - the hash of the tracefile
+ */
+void Search::setCache(ResultCache* rc, unsigned long long hash){
+    cache = rc;
+    trace_hash = hash;
+}
+
+/*
+ * The cache key for a point.
+ * Settings the algorithm ignores are keyed as -1 the same as a single run
+ * so the two can share results.
+ */
+void Search::make_key(SearchPoint* p, RunKey* key){
+    int ref = (algorithm == AGING || algorithm == WORKING_SET_CLOCK) ? p->refresh : -1;
+    int t = (algorithm == WORKING_SET_CLOCK) ? p->tau : -1;
+    ResultCache::makeKey(key, trace_hash, algorithm, p->frames, ref, t, 0, 0);
+}
+
+/*
+ * Looks for a point that has already been run.
+ * Returns NULL if it has not been.
+ */
+SearchPoint* Search::find_point(int frames, int ref, int t){
+    for(size_t i = 0; i < explored.size(); i++){
+        if(explored[i].frames == frames && explored[i].refresh == ref && explored[i].tau == t)
+            return &explored[i];
+    }
+    return NULL;
+}
+
+/*
+ * Runs every point given and fills in its stats.
+ * Points that were already explored are not run again.
+ * The rest are run up to jobs at a time.
+ */
+void Search::probe(std::vector<SearchPoint>& points){
+    std::vector<SearchPoint*> todo;
+    size_t i, j;
+    for(i = 0; i < points.size(); i++){
+        SearchPoint* seen = find_point(points[i].frames, points[i].refresh, points[i].tau);
+        if(seen != NULL) points[i] = *seen;
+        else{
+            // The same point could be asked for twice in one batch.
+            bool dup = false;
+            for(j = 0; j < todo.size(); j++){
+                if(todo[j]->frames == points[i].frames && todo[j]->refresh == points[i].refresh &&
+                        todo[j]->tau == points[i].tau) dup = true;
+            }
+            if(dup) continue;
+            // An earlier run may have already done it.
+            RunKey key;
+            RunStats stats;
+            if(cache != NULL){
+                make_key(&points[i], &key);
+                if(cache->lookup(&key, &stats)){
+                    points[i].mem_accesses = stats.mem_accesses;
+                    points[i].page_faults = stats.page_faults;
+                    points[i].total_writes = stats.total_writes;
+                    set_rate(&points[i]);
+                    explored.push_back(points[i]);
+                    continue;
+                }
+            }
+            todo.push_back(&points[i]);
+        }
+    }
+    
+    // Run the batch jobs at a time.
+    for(i = 0; i < todo.size(); i += jobs){
+        std::vector<std::thread> workers;
+        for(j = i; j < todo.size() && j < i + jobs; j++){
+            workers.push_back(std::thread(run_point, trace, algorithm, todo[j]));
+        }
+        for(j = 0; j < workers.size(); j++) workers[j].join();
+        
+        // Save each batch as it finishes so an interrupted search loses little.
+        for(j = i; j < todo.size() && j < i + jobs; j++){
+            set_rate(todo[j]);
+            explored.push_back(*todo[j]);
+            if(cache != NULL){
+                RunKey key;
+                RunStats stats;
+                memset(&stats, 0, sizeof(stats));
+                stats.mem_accesses = todo[j]->mem_accesses;
+                stats.page_faults = todo[j]->page_faults;
+                stats.total_writes = todo[j]->total_writes;
+                make_key(todo[j], &key);
+                cache->store(&key, &stats);
+            }
+        }
+    }
+    // Fill in any duplicates from what was just run.
+    for(i = 0; i < points.size(); i++){
+        points[i] = *find_point(points[i].frames, points[i].refresh, points[i].tau);
+    }
+}
+
+/*
+ * Searches refresh and tau one at a time for the given frames.
+ * Each pass tries the whole grid for one parameter in parallel and keeps the best.
+ * Stops once neither parameter improves the fault rate.
+ */
+SearchPoint Search::coordinate_search(int frames){
+    SearchPoint cur = start;
+    cur.frames = frames;
+    if(refresh != -1) cur.refresh = refresh;
+    // Only the working set clock has a tau. Aging ignores -t.
+    if(tau != -1 && algorithm == WORKING_SET_CLOCK) cur.tau = tau;
+    std::vector<SearchPoint> line(1, cur);
+    probe(line);
+    cur = line[0];
+    
+    bool improved = true;
+    while(improved){
+        improved = false;
+        for(int coord = 0; coord < 2; coord++){
+            // Skip anything pinned or not used by the algorithm.
+            if(coord == 0 && refresh != -1) continue;
+            if(coord == 1 && (algorithm != WORKING_SET_CLOCK || tau != -1)) continue;
+            line.clear();
+            for(int v = 1; v <= PARAM_GRID_MAX; v *= PARAM_GRID_STEP){
+                SearchPoint p = cur;
+                if(coord == 0) p.refresh = v;
+                else p.tau = v;
+                line.push_back(p);
+            }
+            probe(line);
+            for(size_t i = 0; i < line.size(); i++){
+                if(line[i].fault_rate < cur.fault_rate){
+                    cur = line[i];
+                    improved = true;
+                }
+            }
+        }
+    }
+    // The next frame count is likely to want similar parameters.
+    start = cur;
+    return cur;
+}
+
+/*
+ * Finds the best point for a number of frames.
+ */
+SearchPoint Search::evaluate(int frames){
+    if(algorithm == AGING || algorithm == WORKING_SET_CLOCK) return coordinate_search(frames);
+    std::vector<SearchPoint> points(1, start);
+    points[0].frames = frames;
+    probe(points);
+    return points[0];
+}
+
+/*
+ * Bisects the number of frames for the smallest that meets the target.
+ * This assumes more frames never means more faults.
+ * That holds for opt but Belady's anomaly can break it for the others.
+ * Opt and clock split the range jobs ways at once.
+ * Aging and working set clock bisect and run their parameter grid in parallel.
+ */
+void Search::run(){
+    int lo = 0; // Zero frames never meets the target.
+    int hi = max_frames;
+    size_t i;
+    if(hi < 1) hi = trace->getSize() ? trace->countPages() : 1;
+    
+    // First make sure the target can be met at all.
+    best = evaluate(hi);
+    found = (best.fault_rate <= target);
+    if(!found) return;
+    
+    bool tuned = (algorithm == AGING || algorithm == WORKING_SET_CLOCK);
+    int ways = tuned ? 1 : jobs;
+    while(hi - lo > 1){
+        std::vector<SearchPoint> points;
+        for(int k = 1; k <= ways; k++){
+            int m = lo + (int)((long long)(hi - lo) * k / (ways + 1));
+            if(m <= lo || m >= hi) continue;
+            if(!points.empty() && points.back().frames == m) continue;
+            SearchPoint p = start;
+            p.frames = m;
+            points.push_back(p);
+        }
+        if(tuned){
+            for(i = 0; i < points.size(); i++) points[i] = evaluate(points[i].frames);
+        }
+        else probe(points);
+        
+        // The first point that meets the target is the new upper bound.
+        int new_lo = lo;
+        for(i = 0; i < points.size(); i++){
+            if(points[i].fault_rate <= target){
+                hi = points[i].frames;
+                best = points[i];
+                break;
+            }
+            new_lo = points[i].frames;
+        }
+        lo = new_lo;
+    }
+}
+
+/*
+ * Prints every point that was explored and the minimal configuration.
+ */
+void Search::printResults(){
+    std::vector<SearchPoint> curve = explored;
+    std::sort(curve.begin(), curve.end(), point_less);
+    switch(algorithm){
+        case OPT:
+            printf("Opt Algorithm");
+            break;
+        case CLOCK:
+            printf("Clock Algorithm");
+            break;
+        case AGING:
+            printf("Aging Algorithm");
+            break;
+        case WORKING_SET_CLOCK:
+            printf("Working Set Clock Algorithm");
+            break;
+    }
+    printf(" search for faults/access <= %g\n", target);
+    printf("%8s %8s %8s %12s %12s %12s %14s\n",
+            "Frames", "Refresh", "Tau", "Accesses", "Faults", "Writes", "Faults/Access");
+    for(size_t i = 0; i < curve.size(); i++){
+        printf("%8d %8d %8d %12u %12d %12d %14.6f\n", curve[i].frames, curve[i].refresh,
+                curve[i].tau, curve[i].mem_accesses, curve[i].page_faults,
+                curve[i].total_writes, curve[i].fault_rate);
+    }
+    if(found) printf("Minimal configuration: -n %d", best.frames);
+    else printf("Target not met. Best found: -n %d", best.frames);
+    if(best.refresh != -1) printf(" -r %d", best.refresh);
+    if(best.tau != -1) printf(" -t %d", best.tau);
+    printf(" (%d faults, %g faults/access)\n", best.page_faults, best.fault_rate);
+}
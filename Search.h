@@ -0,0 +1,65 @@
+/* 
+ * File:   Search.h
+ * Author: jacob
+ *
+ * Created on October 19, 2026, 1:05 PM
+ */
+
+#ifndef SEARCH_H
+#define	SEARCH_H
+#include <vector>
+#include "Trace.h"
+#include "Cache.h"
+#define PARAM_GRID_STEP 4 // Refresh and tau are searched in powers of this.
+#define PARAM_GRID_MAX 1048576 // Largest refresh or tau tried.
+
+typedef struct SearchPoint{
+    int frames; // Number of frames probed.
+    int refresh; // Refresh used. -1 if the algorithm has none.
+    int tau; // Tau used. -1 if the algorithm has none.
+    unsigned int mem_accesses; // Stats from the run.
+    int page_faults;
+    int total_writes;
+    double fault_rate; // page_faults / mem_accesses
+} SearchPoint;
+
+/*
+ * Finds the smallest number of frames that keeps the fault rate
+ * at or under a target. For aging and working set clock the refresh
+ * and tau are also searched at each frame count.
+ * Every probe runs over the same trace loaded in memory.
+ */
+class Search {
+public:
+    Search(Trace*, int, double);
+    virtual ~Search();
+    void setMaxFrames(int);
+    void setRefresh(int);
+    void setTau(int);
+    void setJobs(int);
+    void setCache(ResultCache*, unsigned long long);
+    void run();
+    void printResults();
+private:
+    void probe(std::vector<SearchPoint>&);
+    SearchPoint* find_point(int, int, int);
+    SearchPoint evaluate(int);
+    SearchPoint coordinate_search(int);
+    void make_key(SearchPoint*, RunKey*);
+    Trace* trace; // The trace every probe runs over.
+    int algorithm; // The algorithm being searched.
+    double target; // Largest allowed faults per access.
+    int max_frames; // Upper bound of the frame search.
+    int refresh; // Fixed refresh. -1 means search it.
+    int tau; // Fixed tau. -1 means search it.
+    int jobs; // How many probes can run at once.
+    ResultCache* cache; // Results from earlier runs. NULL if not used.
+    unsigned long long trace_hash; // Hash of the tracefile for the cache.
+    bool found; // Did any frame count meet the target.
+    SearchPoint best; // The minimal configuration.
+    SearchPoint start; // Where the next coordinate search starts from.
+    std::vector<SearchPoint> explored; // Every point that has been run.
+};
+
+#endif	/* SEARCH_H */
+
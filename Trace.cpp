@@ -0,0 +1,112 @@
+/* 
+ * File:   Trace.cpp
+ * Author: jacob
+ * 
+ * Created on October 19, 2026, 12:10 PM
+ */
+
+#include "Trace.h"
+#include "PageTable.h"
+#include <cstdio>
+#include <cstring>
+
+/*
+ * Constructor
+ * Makes an empty trace that accesses can be added to.
+ */
+Trace::Trace() {
+    loaded = true;
+}
+
+/*
+ * Constructor
+ * Reads the whole tracefile into memory.
+ * 
+ * char* filename - the name of the tracefile to be used
+ */
+Trace::Trace(char* filename) {
+    unsigned int adr;
+    char mode;
+    FILE* tracefile = fopen(filename, "r");
+    loaded = (tracefile != NULL);
+    if(!loaded) return;
+    while(fscanf(tracefile, "%x %c", &adr, &mode) == 2) addAccess(adr, (mode == 'W' || mode == 'w'));
+    fclose(tracefile);
+}
+
+/*
+ * Adds a single access to the end of the trace.
+ */
+void Trace::addAccess(unsigned int adr, bool isWriting){
+    TraceRecord rec;
+    rec.adr = adr;
+    rec.isWriting = isWriting;
+    rec.count = 1;
+    rec.writes = isWriting ? 1 : 0;
+    records.push_back(rec);
+}
+
+Trace::~Trace() {
+}
+
+bool Trace::isLoaded(){
+    return loaded;
+}
+
+int Trace::getSize(){
+    return records.size();
+}
+
+/*
+ * The number of accesses the records stand for.
+ * Same as the size until the trace is reduced.
+ */
+unsigned int Trace::getAccesses(){
+    unsigned int total = 0;
+    for(size_t i = 0; i < records.size(); i++) total += records[i].count;
+    return total;
+}
+
+TraceRecord* Trace::getRecords(){
+    if(records.empty()) return NULL;
+    return &records[0];
+}
+
+/*
+ * Counts how many distinct pages the trace touches.
+ * With this many frames only the compulsory faults are left.
+ */
+int Trace::countPages(){
+    int count = 0;
+    int num_pages = PAGE_ADDRESS_AND >> 12;
+    bool* seen = new bool[num_pages + 1];
+    memset(seen, 0, num_pages + 1);
+    for(size_t i = 0; i < records.size(); i++){
+        unsigned int page = (records[i].adr & PAGE_ADDRESS_AND) >> 12;
+        if(!seen[page]){
+            seen[page] = true;
+            count++;
+        }
+    }
+    delete[] seen;
+    return count;
+}
+
+/*
+ * Collapses runs of accesses to the same page into one weighted record.
+ * Every access after the first in a run is a hit so the page table
+ * can catch up on them all at once. See PageTable::useAddressRun.
+ */
+void Trace::reduce(){
+    size_t out = 0;
+    for(size_t i = 0; i < records.size(); i++){
+        if(out > 0 && ((records[out - 1].adr ^ records[i].adr) & PAGE_ADDRESS_AND) == 0){
+            // Same page as the last record. Fold it in.
+            records[out - 1].count += records[i].count;
+            records[out - 1].writes += records[i].writes;
+            records[out - 1].isWriting |= records[i].isWriting;
+        }
+        else records[out++] = records[i];
+    }
+    records.resize(out);
+}
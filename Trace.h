@@ -0,0 +1,42 @@
+/* 
+ * File:   Trace.h
+ * Author: jacob
+ *
+ * Created on October 19, 2026, 12:10 PM
+ */
+
+#ifndef TRACE_H
+#define	TRACE_H
+#include <vector>
+
+typedef struct TraceRecord{
+    unsigned int adr; // The address that was accessed.
+    bool isWriting; // Was any access a write. The merged dirty bit.
+    unsigned int count; // How many accesses in a row this record stands for.
+    unsigned int writes; // How many of those accesses were writes.
+} TraceRecord;
+
+/*
+ * A tracefile loaded into memory.
+ * This lets many page tables run over the same trace
+ * without having to parse the file again for each one.
+ */
+class Trace {
+public:
+    Trace();
+    Trace(char*);
+    virtual ~Trace();
+    bool isLoaded();
+    int getSize();
+    unsigned int getAccesses();
+    void reduce();
+    void addAccess(unsigned int, bool);
+    int countPages();
+    TraceRecord* getRecords();
+private:
+    bool loaded; // Did the file open.
+    std::vector<TraceRecord> records; // Every access in the file in order.
+};
+
+#endif	/* TRACE_H */
+
@@ -13,28 +13,71 @@
 #include <unistd.h>
 #endif
 #include "PageTable.h"
+#include "Trace.h"
+#include "Search.h"
+#include "Profiler.h"
+#include "Check.h"
+#include "Cache.h"
 #define SUCCESS 0
 #define FAILURE -1
 
 /*
  * GLOBALS
  */
-PageTable* PT;
+PageTable* PT = NULL;
+Trace* TR = NULL; // Only loaded for a search or with -c.
+Search* SR = NULL;
+Profiler* PR = NULL; // Only made when profiling.
+ResultCache* RC = NULL; // Only opened if a cache file is given.
+RunKey RK; // What the run is cached under.
+RunStats CS; // The cached stats when the run was found.
+bool CACHED = false;
 /* 
  * This method is here to interpret the arguments provided
  * it will return 1 if there is an error 0 if success
  * Error messages will be printed if an error occurs.
  */
 void print_help(){
-    puts("vmsim -n <numframes> -a <opt|clock|aging|work> [-r <refresh>][-t <tau>] <tracefile>\n");
+    puts("vmsim -n <numframes> -a <opt|clock|aging|work> [-r <refresh>][-t <tau>] <tracefile>");
+    puts("vmsim -s <target> -a <opt|clock|aging|work> [-n <maxframes>][-r <refresh>][-t <tau>][-j <jobs>] <tracefile>");
+    puts("vmsim --check");
+    puts("vmsim --bench <baselinefile> [<maxdrop%>]\n");
     puts("-h | --help prints this message");
     puts("-n Sets the number of frames in physical memory.");
     puts("-a Sets which algorithm will be used to determine an eviction.");
     puts("-r The refresh rate for the aging algorithm.");
     puts("-t tau for the Working Set algorithm.");
+    puts("-s Searches for the fewest frames with faults/access at or under target.");
+    puts("   -n becomes the largest frame count tried. -r and -t are searched unless given.");
+    puts("-j The number of search probes run at once.");
+    puts("-m Adds a slow memory tier with this many frames. Evicted pages are demoted there.");
+    puts("-p Promotes a page back out of the slow tier on its nth access there. Default 1.");
+    puts("-l <fast>,<slow>,<disk> Access costs in ns for the estimated access time.");
+    puts("-k Profiles which pages and regions cause faults, writes and evictions. With -m also demotions and slow tier hits.");
+    puts("   Prints the top k of each. Memory stays bounded for any trace.");
+    puts("-d Keeps results in this cache file. Anything already in it is not run again.");
+    puts("   The file can be shared by many vmsim runs at once.");
+    puts("-c Loads the trace into memory and collapses repeated accesses to a page first.");
+    puts("   Searches always do this. The results are the same as without it.");
+    puts("--check Runs every algorithm over generated traces and compares against known good stats.");
+    puts("--bench Fails if accesses/sec drop more than maxdrop% under the baseline. Default 20.");
+    puts("        Records the baseline if the file does not exist.");
     puts("Make sure to use a valid trackfile.");
 }
 
+/*
+ * Opens the result cache. Returns false and carries on without it if it cannot.
+ */
+bool open_cache(char* cachefile){
+    RC = new ResultCache(cachefile);
+    if(RC->isOpen()) return true;
+    puts("Failed to open the result cache:");
+    puts(cachefile);
+    delete RC;
+    RC = NULL;
+    return false;
+}
+
 /*
  *  This method is here to read through the arguments provided 
  * It will set globals acordingly
@@ -47,13 +90,21 @@ int readArgs(int argc, char** argv) {
     int frames = -1;
     int param = -1;
     int tau = -1;
+    int jobs = -1;
+    double target = -1;
+    bool collapse = false;
+    int slow = -1;
+    int promote = -1;
+    int top_k = -1;
+    char* cachefile = NULL;
+    unsigned int costs[3] = {FAST_COST, SLOW_COST, DISK_COST};
     char* filename;
     int filename_size = strlen(argv[argc - 1]); // Get the filename string size.
     if(argc == 1){
         print_help();
         return FAILURE;
     }
-    filename = new char[filename_size];
+    filename = new char[filename_size + 1]; // Room for the null terminator.
     strcpy(filename, argv[argc - 1]);
     // Lets iterate throught the args to find the rest of them
     for(i = 1; i < argc - 1; i++){
@@ -86,6 +137,63 @@ int readArgs(int argc, char** argv) {
             i++;
             tau = atoi(argv[i]);
         }
+        else if(!strcmp(argv[i], "-s")){
+            i++;
+            target = atof(argv[i]);
+        }
+        else if(!strcmp(argv[i], "-j")){
+            i++;
+            jobs = atoi(argv[i]);
+        }
+        else if(!strcmp(argv[i], "-c")){
+            collapse = true;
+        }
+        else if(!strcmp(argv[i], "-m")){
+            i++;
+            slow = atoi(argv[i]);
+        }
+        else if(!strcmp(argv[i], "-d")){
+            i++;
+            cachefile = argv[i];
+        }
+        else if(!strcmp(argv[i], "-k")){
+            i++;
+            top_k = atoi(argv[i]);
+        }
+        else if(!strcmp(argv[i], "-p")){
+            i++;
+            promote = atoi(argv[i]);
+        }
+        else if(!strcmp(argv[i], "-l")){
+            i++;
+            if(sscanf(argv[i], "%u,%u,%u", &costs[0], &costs[1], &costs[2]) != 3){
+                print_help();
+                return FAILURE;
+            }
+        }
+    }
+    
+    // A search only needs the algorithm. The rest it can find.
+    if(target >= 0){
+        if(alg == -1){
+            print_help();
+            return FAILURE;
+        }
+        TR = new Trace(filename);
+        if(!TR->isLoaded()){
+            puts("Failed to open the file:");
+            puts(filename);
+            delete TR;
+            return FAILURE;
+        }
+        TR->reduce();
+        SR = new Search(TR, alg, target);
+        if(frames != -1) SR->setMaxFrames(frames);
+        if(param != -1) SR->setRefresh(param);
+        if(tau != -1) SR->setTau(tau);
+        if(jobs != -1) SR->setJobs(jobs);
+        if(cachefile != NULL && open_cache(cachefile)) SR->setCache(RC, ResultCache::hashFile(filename));
+        return SUCCESS;
     }
     
     // Now lets check if the arguments are valid.
@@ -106,8 +214,32 @@ int readArgs(int argc, char** argv) {
         return FAILURE;
     }
     
-    PT = new PageTable(frames, alg, filename);
-    if(!PT->isFileOpen()){
+    if(cachefile != NULL && open_cache(cachefile)){
+        // Only what the run actually uses goes in the key.
+        bool tiered = (slow > 0);
+        ResultCache::makeKey(&RK, ResultCache::hashFile(filename), alg, frames,
+                (alg == AGING || alg == WORKING_SET_CLOCK) ? param : -1,
+                (alg == WORKING_SET_CLOCK) ? tau : -1,
+                tiered ? slow : 0, tiered ? ((promote < 1) ? 1 : promote) : 0);
+        // Looked up now so a hit never loads the trace. A profile needs the run to actually happen.
+        if(top_k <= 0) CACHED = RC->lookup(&RK, &CS);
+    }
+    
+    if(collapse && !CACHED){
+        TR = new Trace(filename);
+        if(!TR->isLoaded()){
+            puts("Failed to open the file:");
+            puts(filename);
+            delete TR;
+            return FAILURE;
+        }
+        unsigned int accesses = TR->getAccesses();
+        TR->reduce();
+        std::cout << "Collapsed " << accesses << " accesses into " << TR->getSize() << " records." << std::endl;
+        PT = new PageTable(frames, alg, TR);
+    }
+    else PT = new PageTable(frames, alg, filename);
+    if(TR == NULL && !PT->isFileOpen()){
         puts("Failed to open the file:");
         puts(filename);
 #ifdef __linux
@@ -127,6 +259,17 @@ int readArgs(int argc, char** argv) {
     if(alg == WORKING_SET_CLOCK){
         PT->setTau(tau);
     }
+    
+    if(slow > 0){
+        PT->setSlowTier(slow);
+        if(promote != -1) PT->setPromoteAfter(promote);
+        PT->setAccessCosts(costs[0], costs[1], costs[2]);
+    }
+    
+    if(top_k > 0){
+        PR = new Profiler(top_k);
+        PT->setProfiler(PR);
+    }
     return SUCCESS;
 }
 
@@ -138,11 +281,39 @@ int readArgs(int argc, char** argv) {
  * Finally it will print the results
  */
 int main(int argc, char** argv) {
+    /* The self checks do not need a tracefile */
+    if(argc >= 2 && !strcmp(argv[1], "--check")) return checkGolden();
+    if(argc >= 3 && !strcmp(argv[1], "--bench"))
+        return checkThroughput(argv[2], (argc >= 4) ? atof(argv[3]) : BENCH_MAX_DROP);
     /* First thing is to read the arguments */
     if(readArgs(argc, argv) == SUCCESS){
-        PT->beginFileTraverse();
-        PT->printTrace();
-        delete PT;
+        if(SR != NULL){
+            // Search mode runs many page tables over the loaded trace.
+            SR->run();
+            SR->printResults();
+            delete SR;
+            delete TR;
+            delete RC;
+        }
+        else{
+            if(CACHED){
+                std::cerr << "Using a cached result." << std::endl;
+                PT->loadStats(&CS);
+            }
+            else{
+                PT->beginFileTraverse();
+                if(RC != NULL){
+                    PT->getStats(&CS);
+                    RC->store(&RK, &CS);
+                }
+            }
+            PT->printTrace();
+            if(PR != NULL) PR->printProfile();
+            delete PT;
+            delete PR;
+            delete TR;
+            delete RC;
+        }
     }
     return 0;
 }